@@ -5,7 +5,7 @@ import os
 import cv2
 import numpy as np
 import logging
-from data_prep_green_threshold import LOWER_GREEN, UPPER_GREEN
+from data_prep_green_threshold import LOWER_GREEN, UPPER_GREEN, log_hsv_bounds_source
 
 def annotate_green_bounding_box(image_path: str) -> None:
     img = cv2.imread(image_path)
@@ -28,6 +28,7 @@ def annotate_green_bounding_box(image_path: str) -> None:
 
 if __name__ == "__main__":
     logging.basicConfig(level=logging.DEBUG, format='%(levelname)s: %(message)s')
+    log_hsv_bounds_source()
     green_dir = 'data/green'
     for fname in os.listdir(green_dir):
         if not fname.lower().endswith('.jpg'):
@@ -1,7 +1,7 @@
 import os
 import shutil
 import logging
-from data_prep_green_threshold import is_green_image
+from data_prep_green_threshold import is_green_image, log_hsv_bounds_source
 from typing import List
 import sys
 
@@ -31,6 +31,7 @@ def batch_classify_images_recursive(raw_root: str, green_dir: str, non_green_dir
 
 if __name__ == "__main__":
     logging.basicConfig(level=logging.DEBUG, format='%(levelname)s: %(message)s')
+    log_hsv_bounds_source()
     # Allow user to specify the root directory to process
     if len(sys.argv) > 1:
         raw_root = sys.argv[1]
@@ -1,11 +1,51 @@
 import cv2
+import json
+import os
 import numpy as np
 import logging
-from typing import Any
+from typing import Any, Tuple
 
-# HSV bounds for green
-LOWER_GREEN = np.array([50, 100, 100])
-UPPER_GREEN = np.array([70, 255, 255])
+# Shared HSV config written by the C++ hsv_calibrate tool, resolved against the
+# repo root so it is found regardless of the working directory
+HSV_CONFIG_PATH = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'hsv_bounds.json'))
+# OpenCV HSV maxima (H, S, V); must match loadHsvBounds() in hsv_config.h
+HSV_MAX = (179, 255, 255)
+
+def load_hsv_bounds(default_lower: np.ndarray, default_upper: np.ndarray,
+                    path: str = HSV_CONFIG_PATH) -> Tuple[np.ndarray, np.ndarray]:
+    """Return (lower, upper) HSV bounds from the calibrated config, or the defaults if it is missing or invalid."""
+    if not os.path.isfile(path):
+        logging.info(f"No HSV config at {path}; using fallback bounds {default_lower.tolist()}-{default_upper.tolist()}")
+        return default_lower, default_upper
+    try:
+        with open(path) as f:
+            config = json.load(f)
+        for key in ('lower', 'upper'):
+            values = config[key]
+            if not isinstance(values, list) or not all(isinstance(v, int) and not isinstance(v, bool) for v in values):
+                raise ValueError(f"'{key}' must be a list of integers")
+        lower = np.array(config['lower'], dtype=int)
+        upper = np.array(config['upper'], dtype=int)
+        if lower.shape != (3,) or upper.shape != (3,):
+            raise ValueError("'lower' and 'upper' must each have 3 values")
+        if np.any(lower < 0) or np.any(upper > np.array(HSV_MAX)) or np.any(lower > upper):
+            raise ValueError(f"out-of-range bounds {lower.tolist()}-{upper.tolist()}")
+        logging.info(f"Loaded HSV bounds from {path}: {lower.tolist()}-{upper.tolist()}")
+        return lower, upper
+    except Exception as e:
+        logging.error(f"Invalid HSV config {path}: {e}; using fallback bounds {default_lower.tolist()}-{default_upper.tolist()}")
+        return default_lower, default_upper
+
+# HSV bounds for green (calibrated config overrides the hand-tuned fallback)
+FALLBACK_LOWER_GREEN = np.array([50, 100, 100])
+FALLBACK_UPPER_GREEN = np.array([70, 255, 255])
+LOWER_GREEN, UPPER_GREEN = load_hsv_bounds(FALLBACK_LOWER_GREEN, FALLBACK_UPPER_GREEN)
+
+def log_hsv_bounds_source() -> None:
+    """Log where LOWER_GREEN/UPPER_GREEN came from. The import-time load runs before
+    logging is configured, so scripts call this after logging.basicConfig()."""
+    source = 'hand-tuned fallback' if LOWER_GREEN is FALLBACK_LOWER_GREEN else HSV_CONFIG_PATH
+    logging.info(f"Using HSV bounds {LOWER_GREEN.tolist()}-{UPPER_GREEN.tolist()} from {source}")
 
 # data_prep_green_threshold.py
 # Defines HSV green color thresholds and provides a helper function to classify images as green or non-green based on green pixel ratio.
@@ -32,6 +72,7 @@ def is_green_image(path: str, threshold: float = 0.05) -> bool:
 
 if __name__ == "__main__":
     logging.basicConfig(level=logging.DEBUG, format='%(levelname)s: %(message)s')
+    log_hsv_bounds_source()
     # Example usage: test on all files in data/raw_images
     import os
     raw_dir = 'data/raw_images'
@@ -4,13 +4,15 @@
 import cv2
 import numpy as np
 import logging
+from data_prep_green_threshold import load_hsv_bounds
 
 logging.basicConfig(level=logging.INFO, format='%(levelname)s: %(message)s')
 
 # ENGINEERING: Broad HSV bounds for green (covers yellow-green to blue-green)
-# These can be further tuned or learned from data
-DEFAULT_LOWER_GREEN = np.array([25, 120, 120])   # H, S, V (calibrated for neon green/yellow tennis ball)
-DEFAULT_UPPER_GREEN = np.array([45, 255, 255])
+# Learned bounds from hsv_calibrate (hsv_bounds.json) take precedence when present
+DEFAULT_LOWER_GREEN, DEFAULT_UPPER_GREEN = load_hsv_bounds(
+    np.array([25, 120, 120]),   # H, S, V (calibrated for neon green/yellow tennis ball)
+    np.array([45, 255, 255]))
 
 WINDOW = 'Green Object Detection'
 
@@ -80,8 +82,7 @@ def main() -> None:
     cv2.destroyAllWindows()
 
 # ML/DATA-DRIVEN IMPROVEMENT:
-# - Analyze your dataset to find the HSV distribution of green pixels.
-# - Use k-means or histogram analysis to set optimal bounds.
+# - Run ./hsv_calibrate to learn bounds from data/train histograms (writes hsv_bounds.json).
 # - Optionally, train a simple classifier (e.g., SVM, kNN) on pixel HSV values for robust green detection.
 
 if __name__ == '__main__':
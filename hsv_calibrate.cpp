@@ -0,0 +1,318 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <cstdint>
+#include <cctype>
+#include <filesystem>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include "hsv_config.h"
+
+// hsv_calibrate.cpp
+// Learns green HSV bounds from the labelled dataset instead of hand tuning.
+// Streams data/train/green and data/train/non_green across all cores, builds a
+// 3D HSV histogram per thread and class, merges them, then searches for the
+// HSV box that maximizes (green pixels inside) - (non-green pixels inside),
+// each as a fraction of its class total. The result is written to
+// hsv_bounds.json, which the detector and data-prep scripts load.
+
+namespace fs = std::filesystem;
+
+// Histogram resolution (OpenCV HSV: H 0-179, S/V 0-255)
+static constexpr int H_BIN_WIDTH = 4;
+static constexpr int S_BIN_WIDTH = 8;
+static constexpr int V_BIN_WIDTH = 8;
+static constexpr int H_BINS = 180 / H_BIN_WIDTH;
+static constexpr int S_BINS = 256 / S_BIN_WIDTH;
+static constexpr int V_BINS = 256 / V_BIN_WIDTH;
+static constexpr int TOTAL_BINS = H_BINS * S_BINS * V_BINS;
+
+static const std::vector<std::string> IMAGE_EXTS = {".jpg", ".jpeg", ".png", ".bmp", ".tiff"};
+
+enum ImageClass { GREEN = 0, NON_GREEN = 1, CLASS_COUNT = 2 };
+
+struct ImageTask {
+    std::string path;
+    ImageClass label;
+};
+
+struct HsvHistogram {
+    std::vector<uint64_t> counts[CLASS_COUNT];
+    uint64_t images[CLASS_COUNT] = {0, 0};
+    uint64_t failed = 0;
+
+    HsvHistogram() {
+        for (auto& c : counts) {
+            c.assign(TOTAL_BINS, 0);
+        }
+    }
+
+    void merge(const HsvHistogram& other) {
+        for (int label = 0; label < CLASS_COUNT; ++label) {
+            for (int i = 0; i < TOTAL_BINS; ++i) {
+                counts[label][i] += other.counts[label][i];
+            }
+            images[label] += other.images[label];
+        }
+        failed += other.failed;
+    }
+
+    uint64_t total(int label) const {
+        uint64_t sum = 0;
+        for (uint64_t c : counts[label]) {
+            sum += c;
+        }
+        return sum;
+    }
+};
+
+struct CalibrationResult {
+    int hLow = 0, hHigh = 0, sLow = 0, sHigh = 0, vLow = 0, vHigh = 0;  // Inclusive bin indices
+    double separation = -1.0;
+};
+
+inline int binIndex(int h, int s, int v) {
+    return (h * S_BINS + s) * V_BINS + v;
+}
+
+void listImages(const std::string& dir, ImageClass label, std::vector<ImageTask>& tasks) {
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code typeEc;
+        if (!it->is_regular_file(typeEc)) {
+            continue;
+        }
+        std::string ext = it->path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (std::find(IMAGE_EXTS.begin(), IMAGE_EXTS.end(), ext) != IMAGE_EXTS.end()) {
+            tasks.push_back({it->path().string(), label});
+        }
+    }
+    if (ec) {
+        std::cerr << "Failed to list '" << dir << "': " << ec.message() << std::endl;
+    }
+}
+
+void histogramWorker(const std::vector<ImageTask>& tasks, std::atomic<size_t>& nextTask, HsvHistogram& hist) {
+    cv::Mat bgr, hsv;
+    size_t index;
+    while ((index = nextTask.fetch_add(1, std::memory_order_relaxed)) < tasks.size()) {
+        const ImageTask& task = tasks[index];
+        bgr = cv::imread(task.path, cv::IMREAD_COLOR);
+        if (bgr.empty()) {
+            ++hist.failed;
+            continue;
+        }
+        cv::cvtColor(bgr, hsv, cv::COLOR_BGR2HSV);
+
+        std::vector<uint64_t>& counts = hist.counts[task.label];
+        for (int row = 0; row < hsv.rows; ++row) {
+            const cv::Vec3b* px = hsv.ptr<cv::Vec3b>(row);
+            for (int col = 0; col < hsv.cols; ++col) {
+                ++counts[binIndex(px[col][0] / H_BIN_WIDTH, px[col][1] / S_BIN_WIDTH, px[col][2] / V_BIN_WIDTH)];
+            }
+        }
+        ++hist.images[task.label];
+    }
+}
+
+// For each H/S range the best V range is a maximum-subarray over the V
+// profile, so only H/S ranges are enumerated (in parallel over hLow).
+CalibrationResult findBestBounds(const HsvHistogram& hist, unsigned numThreads) {
+    const double greenTotal = static_cast<double>(hist.total(GREEN));
+    const double nonGreenTotal = static_cast<double>(hist.total(NON_GREEN));
+
+    // Per-V 2D prefix sums over (H, S) of the normalized class difference
+    const int stride = S_BINS + 1;
+    const int plane = (H_BINS + 1) * stride;
+    std::vector<double> prefix(static_cast<size_t>(V_BINS) * plane, 0.0);
+    for (int v = 0; v < V_BINS; ++v) {
+        double* p = &prefix[static_cast<size_t>(v) * plane];
+        for (int h = 0; h < H_BINS; ++h) {
+            for (int s = 0; s < S_BINS; ++s) {
+                int bin = binIndex(h, s, v);
+                double diff = hist.counts[GREEN][bin] / greenTotal - hist.counts[NON_GREEN][bin] / nonGreenTotal;
+                p[(h + 1) * stride + s + 1] = diff + p[h * stride + s + 1] + p[(h + 1) * stride + s] - p[h * stride + s];
+            }
+        }
+    }
+
+    std::atomic<int> nextHLow(0);
+    std::vector<CalibrationResult> results(numThreads);
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            CalibrationResult& best = results[t];
+            int hLow;
+            while ((hLow = nextHLow.fetch_add(1)) < H_BINS) {
+                for (int hHigh = hLow; hHigh < H_BINS; ++hHigh) {
+                    for (int sLow = 0; sLow < S_BINS; ++sLow) {
+                        for (int sHigh = sLow; sHigh < S_BINS; ++sHigh) {
+                            double run = 0.0;
+                            int runStart = 0;
+                            for (int v = 0; v < V_BINS; ++v) {
+                                const double* p = &prefix[static_cast<size_t>(v) * plane];
+                                double column = p[(hHigh + 1) * stride + sHigh + 1] - p[hLow * stride + sHigh + 1]
+                                              - p[(hHigh + 1) * stride + sLow] + p[hLow * stride + sLow];
+                                if (run <= 0.0) {
+                                    run = column;
+                                    runStart = v;
+                                } else {
+                                    run += column;
+                                }
+                                if (run > best.separation) {
+                                    best.separation = run;
+                                    best.hLow = hLow;
+                                    best.hHigh = hHigh;
+                                    best.sLow = sLow;
+                                    best.sHigh = sHigh;
+                                    best.vLow = runStart;
+                                    best.vHigh = v;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return *std::max_element(results.begin(), results.end(),
+        [](const CalibrationResult& a, const CalibrationResult& b) { return a.separation < b.separation; });
+}
+
+double boxFraction(const HsvHistogram& hist, ImageClass label, const CalibrationResult& r) {
+    uint64_t inside = 0;
+    for (int h = r.hLow; h <= r.hHigh; ++h) {
+        for (int s = r.sLow; s <= r.sHigh; ++s) {
+            for (int v = r.vLow; v <= r.vHigh; ++v) {
+                inside += hist.counts[label][binIndex(h, s, v)];
+            }
+        }
+    }
+    uint64_t total = hist.total(label);
+    return total ? static_cast<double>(inside) / total : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+    // Usage (from the repo root): ./build/hsv_calibrate [green_dir] [non_green_dir] [output.json]
+    // Paths are relative to the working directory, like the data-prep scripts
+    std::string greenDir = "data/train/green";
+    std::string nonGreenDir = "data/train/non_green";
+    std::string outputPath = HSV_CONFIG_DEFAULT_PATH;
+
+    // Parse command line arguments
+    if (argc > 1) greenDir = argv[1];
+    if (argc > 2) nonGreenDir = argv[2];
+    if (argc > 3) outputPath = argv[3];
+
+    unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << "HSV Bound Calibration" << std::endl;
+    std::cout << "=====================" << std::endl;
+    std::cout << "Green images: " << greenDir << std::endl;
+    std::cout << "Non-green images: " << nonGreenDir << std::endl;
+    std::cout << "Threads: " << numThreads << std::endl;
+    std::cout << "=====================" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<ImageTask> tasks;
+    listImages(greenDir, GREEN, tasks);
+    listImages(nonGreenDir, NON_GREEN, tasks);
+    if (tasks.empty()) {
+        std::cerr << "No images found" << std::endl;
+        return 1;
+    }
+
+    // Parallelism comes from the worker threads; keep OpenCV itself sequential
+    cv::setNumThreads(0);
+
+    std::atomic<size_t> nextTask(0);
+    std::vector<HsvHistogram> perThread(numThreads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back(histogramWorker, std::cref(tasks), std::ref(nextTask), std::ref(perThread[t]));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    HsvHistogram hist;
+    for (const auto& h : perThread) {
+        hist.merge(h);
+    }
+
+    auto histDone = std::chrono::steady_clock::now();
+    std::cout << "Processed " << hist.images[GREEN] << " green, " << hist.images[NON_GREEN]
+              << " non-green images (" << hist.failed << " unreadable) in "
+              << std::fixed << std::setprecision(2)
+              << std::chrono::duration<double>(histDone - start).count() << " s" << std::endl;
+
+    if (hist.total(GREEN) == 0 || hist.total(NON_GREEN) == 0) {
+        std::cerr << "Both classes need at least one readable image" << std::endl;
+        return 1;
+    }
+
+    CalibrationResult best = findBestBounds(hist, numThreads);
+
+    HsvBounds bounds;
+    bounds.lower[0] = best.hLow * H_BIN_WIDTH;
+    bounds.lower[1] = best.sLow * S_BIN_WIDTH;
+    bounds.lower[2] = best.vLow * V_BIN_WIDTH;
+    bounds.upper[0] = std::min(179, (best.hHigh + 1) * H_BIN_WIDTH - 1);
+    bounds.upper[1] = (best.sHigh + 1) * S_BIN_WIDTH - 1;
+    bounds.upper[2] = (best.vHigh + 1) * V_BIN_WIDTH - 1;
+
+    double greenFraction = boxFraction(hist, GREEN, best);
+    double nonGreenFraction = boxFraction(hist, NON_GREEN, best);
+
+    auto end = std::chrono::steady_clock::now();
+    std::cout << std::setprecision(4)
+              << "Lower HSV: [" << bounds.lower[0] << ", " << bounds.lower[1] << ", " << bounds.lower[2] << "]" << std::endl
+              << "Upper HSV: [" << bounds.upper[0] << ", " << bounds.upper[1] << ", " << bounds.upper[2] << "]" << std::endl
+              << "Separation: " << best.separation
+              << " (green pixels inside " << greenFraction << ", non-green " << nonGreenFraction << ")" << std::endl
+              << std::setprecision(2)
+              << "Total time: " << std::chrono::duration<double>(end - start).count() << " s" << std::endl;
+
+    std::ostringstream extra;
+    extra << std::fixed << std::setprecision(4)
+          << "\"separation\": " << best.separation << ",\n"
+          << "  \"green_fraction\": " << greenFraction << ",\n"
+          << "  \"non_green_fraction\": " << nonGreenFraction << ",\n"
+          << "  \"green_images\": " << hist.images[GREEN] << ",\n"
+          << "  \"non_green_images\": " << hist.images[NON_GREEN];
+
+    std::string error;
+    if (!saveHsvBounds(bounds, error, outputPath, extra.str())) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    // Read the file back through the same loader the detector uses
+    HsvBounds written;
+    if (!loadHsvBounds(written, error, outputPath) ||
+        !std::equal(bounds.lower, bounds.lower + 3, written.lower) ||
+        !std::equal(bounds.upper, bounds.upper + 3, written.upper)) {
+        std::cerr << "Written HSV config did not load back: " << error << std::endl;
+        return 1;
+    }
+
+    std::error_code ec;
+    fs::path absolutePath = fs::absolute(outputPath, ec);
+    std::cout << "Wrote " << (ec ? outputPath : absolutePath.string()) << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+#ifndef HSV_CONFIG_H
+#define HSV_CONFIG_H
+
+// hsv_config.h
+// Shared HSV bound configuration for green object detection. Written by
+// hsv_calibrate and read by the C++ detector and the Python data-prep stages
+// (see load_hsv_bounds() in data_prep_green_threshold.py).
+//
+// File format (JSON, OpenCV HSV ranges: H 0-179, S/V 0-255):
+//   { "lower": [H, S, V], "upper": [H, S, V], ... }
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static constexpr const char* HSV_CONFIG_DEFAULT_PATH = "hsv_bounds.json";
+
+struct HsvBounds {
+    int lower[3];
+    int upper[3];
+};
+
+namespace hsv_config_detail {
+
+inline const char* skipSpace(const char* cursor) {
+    while (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t') {
+        ++cursor;
+    }
+    return cursor;
+}
+
+// Parses "key": [a, b, c] in text. Requires exactly three comma-separated
+// integers that fit in an int, matching what json.load accepts in Python.
+inline bool parseTriple(const std::string& text, const std::string& key, int out[3]) {
+    size_t pos = text.find("\"" + key + "\"");
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos = text.find('[', pos);
+    if (pos == std::string::npos) {
+        return false;
+    }
+
+    const char* cursor = skipSpace(text.c_str() + pos + 1);
+    for (int i = 0; i < 3; ++i) {
+        char* end = nullptr;
+        errno = 0;
+        long value = std::strtol(cursor, &end, 10);
+        if (end == cursor || errno == ERANGE || value < INT_MIN || value > INT_MAX) {
+            return false;
+        }
+        out[i] = static_cast<int>(value);
+        cursor = skipSpace(end);
+
+        char expected = (i < 2) ? ',' : ']';
+        if (*cursor != expected) {
+            return false;
+        }
+        cursor = skipSpace(cursor + 1);
+    }
+    return true;
+}
+
+} // namespace hsv_config_detail
+
+inline bool loadHsvBounds(HsvBounds& bounds, std::string& errorMessage,
+                          const std::string& path = HSV_CONFIG_DEFAULT_PATH) {
+    std::ifstream file(path);
+    if (!file) {
+        errorMessage = "Failed to open HSV config '" + path + "'";
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    HsvBounds parsed;
+    if (!hsv_config_detail::parseTriple(text, "lower", parsed.lower) ||
+        !hsv_config_detail::parseTriple(text, "upper", parsed.upper)) {
+        errorMessage = "HSV config '" + path + "' needs \"lower\"/\"upper\" as three integers each";
+        return false;
+    }
+
+    static constexpr int maxValue[3] = {179, 255, 255};
+    for (int i = 0; i < 3; ++i) {
+        if (parsed.lower[i] < 0 || parsed.upper[i] > maxValue[i] || parsed.lower[i] > parsed.upper[i]) {
+            errorMessage = "HSV config '" + path + "' has out-of-range bounds";
+            return false;
+        }
+    }
+
+    bounds = parsed;
+    return true;
+}
+
+// extraFields is inserted verbatim after the bounds, e.g. "\"separation\": 0.81"
+inline bool saveHsvBounds(const HsvBounds& bounds, std::string& errorMessage,
+                          const std::string& path = HSV_CONFIG_DEFAULT_PATH,
+                          const std::string& extraFields = "") {
+    std::ofstream file(path);
+    if (!file) {
+        errorMessage = "Failed to write HSV config '" + path + "'";
+        return false;
+    }
+
+    file << "{\n"
+         << "  \"lower\": [" << bounds.lower[0] << ", " << bounds.lower[1] << ", " << bounds.lower[2] << "],\n"
+         << "  \"upper\": [" << bounds.upper[0] << ", " << bounds.upper[1] << ", " << bounds.upper[2] << "]";
+    if (!extraFields.empty()) {
+        file << ",\n  " << extraFields;
+    }
+    file << "\n}\n";
+
+    if (!file) {
+        errorMessage = "Failed to write HSV config '" + path + "'";
+        return false;
+    }
+    return true;
+}
+
+#endif // HSV_CONFIG_H
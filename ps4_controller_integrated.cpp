@@ -4,6 +4,7 @@
 #include <stdexcept>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cmath>
 #include <iomanip>
 #include <atomic>
@@ -15,6 +16,7 @@
 #include <cstring>
 #include <sys/ioctl.h>
 #include <SDL2/SDL.h>
+#include "telemetry_shm.h"
 
 // Debug configuration
 #define DEBUG_MODE 1
@@ -41,6 +43,11 @@ private:
     std::atomic<bool> running_;
     std::atomic<bool> shutdownRequested_;
     
+    // Telemetry components
+    TelemetryWriter telemetry_;
+    std::atomic<uint32_t> buttonMask_;
+    bool quietConsole_;  // Suppress [BUTTON]/[JOYSTICK] lines while telemetry is open
+    
     // Configuration
     static constexpr float DEADZONE_THRESHOLD = 0.1f;
     static constexpr int UPDATE_RATE_MS = 50;  // 20 FPS for responsive input
@@ -58,7 +65,9 @@ public:
         joystick_(nullptr),
         joystickInitialized_(false),
         running_(false),
-        shutdownRequested_(false) {
+        shutdownRequested_(false),
+        buttonMask_(0),
+        quietConsole_(false) {
         DEBUG_LOG(2, "PS4Controller constructor called");
     }
 
@@ -71,12 +80,13 @@ public:
     PS4Controller(const PS4Controller&) = delete;
     PS4Controller& operator=(const PS4Controller&) = delete;
 
-    bool initialize(const std::string& devicePath = "") {
+    bool initialize(const std::string& devicePath = "", bool quietConsole = false) {
         DEBUG_LOG(2, "Initializing PS4Controller");
         
         if (!devicePath.empty()) {
             inputDevice_ = devicePath;
         }
+        quietConsole_ = quietConsole;
         
         try {
             // Initialize SDL for joystick support
@@ -91,6 +101,14 @@ public:
                 return false;
             }
             
+            // Telemetry is optional; the controller runs without it
+            std::string telemetryError;
+            if (telemetry_.open(telemetryError)) {
+                DEBUG_LOG(2, "Telemetry published at " << TELEMETRY_SHM_NAME);
+            } else {
+                DEBUG_LOG(1, "Warning: Telemetry disabled: " << telemetryError);
+            }
+            
             running_ = true;
             DEBUG_LOG(2, "PS4Controller initialization successful");
             return true;
@@ -127,6 +145,7 @@ public:
         std::cout << "=======================================" << std::endl;
         std::cout << "Button testing: " << inputDevice_ << std::endl;
         std::cout << "Joystick testing: SDL2" << std::endl;
+        std::cout << "Telemetry: " << (telemetry_.isOpen() ? TELEMETRY_SHM_NAME : "disabled") << std::endl;
         std::cout << "Press Ctrl+C to exit" << std::endl;
         std::cout << "=======================================" << std::endl;
         
@@ -230,6 +249,7 @@ private:
             joystickInitialized_ = false;
         }
         
+        telemetry_.close();
         SDL_Quit();
     }
 
@@ -257,8 +277,17 @@ private:
                 bool pressed = (ev.value == 1);
                 std::string buttonName = getButtonName(ev.code);
                 
+                uint32_t bit = getButtonBit(ev.code);
+                if (pressed) {
+                    buttonMask_.fetch_or(bit, std::memory_order_relaxed);
+                } else {
+                    buttonMask_.fetch_and(~bit, std::memory_order_relaxed);
+                }
+                
                 if (!buttonName.empty()) {
-                    std::cout << "[BUTTON] " << buttonName << (pressed ? " PRESSED" : " RELEASED") << std::endl;
+                    if (consoleOutputEnabled()) {
+                        std::cout << "[BUTTON] " << buttonName << (pressed ? " PRESSED" : " RELEASED") << std::endl;
+                    }
                 } else {
                     DEBUG_LOG(3, "Unhandled key code: " << ev.code);
                 }
@@ -271,7 +300,11 @@ private:
     void joystickMonitoringLoop() {
         DEBUG_LOG(2, "Joystick monitoring loop started");
         
+        uint64_t lastLoopNs = telemetryNowNs();
+        
         while (running_ && !shutdownRequested_) {
+            uint64_t loopStartNs = telemetryNowNs();
+            
             SDL_Event event;
             while (SDL_PollEvent(&event)) {
                 // Handle SDL events if needed
@@ -280,11 +313,19 @@ private:
             if (joystickInitialized_ && joystick_) {
                 float throttle, steering;
                 if (getJoystickValues(throttle, steering)) {
-                    std::cout << "[JOYSTICK] Throttle: " << std::fixed << std::setprecision(2) 
-                              << throttle << " | Steering: " << steering << std::endl;
+                    // Publish first so loopWorkUs excludes console I/O
+                    if (telemetry_.isOpen()) {
+                        publishTelemetry(throttle, steering, loopStartNs, lastLoopNs);
+                    }
+                    
+                    if (consoleOutputEnabled()) {
+                        std::cout << "[JOYSTICK] Throttle: " << std::fixed << std::setprecision(2) 
+                                  << throttle << " | Steering: " << steering << std::endl;
+                    }
                 }
             }
             
+            lastLoopNs = loopStartNs;
             std::this_thread::sleep_for(std::chrono::milliseconds(UPDATE_RATE_MS));
         }
         
@@ -319,6 +360,27 @@ private:
         }
     }
 
+    bool consoleOutputEnabled() const {
+        return !(quietConsole_ && telemetry_.isOpen());
+    }
+
+    void publishTelemetry(float throttle, float steering, uint64_t loopStartNs, uint64_t lastLoopNs) {
+        TelemetryRecord record{};
+        for (int axis = 0; axis < 4; ++axis) {
+            record.rawAxes[axis] = SDL_JoystickGetAxis(joystick_, axis);
+        }
+        record.throttle = throttle;
+        record.steering = steering;
+        record.buttons = buttonMask_.load(std::memory_order_relaxed);
+        record.loopPeriodUs = static_cast<uint32_t>((loopStartNs - lastLoopNs) / 1000);
+        // No on-board detector feeds this process yet; detectionValid stays 0
+        record.detectionValid = 0;
+        record.timestampNs = telemetryNowNs();
+        record.loopWorkUs = static_cast<uint32_t>((record.timestampNs - loopStartNs) / 1000);
+        
+        telemetry_.publish(record);
+    }
+
     float applyDeadzone(float value) const {
         return (std::abs(value) < DEADZONE_THRESHOLD) ? 0.0f : value;
     }
@@ -341,6 +403,25 @@ private:
             default:          return "";
         }
     }
+
+    uint32_t getButtonBit(int code) {
+        switch (code) {
+            case BTN_NORTH:   return TELEMETRY_BTN_TRIANGLE;
+            case BTN_SOUTH:   return TELEMETRY_BTN_CROSS;
+            case BTN_WEST:    return TELEMETRY_BTN_SQUARE;
+            case BTN_EAST:    return TELEMETRY_BTN_CIRCLE;
+            case BTN_TL:      return TELEMETRY_BTN_L1;
+            case BTN_TR:      return TELEMETRY_BTN_R1;
+            case BTN_TL2:     return TELEMETRY_BTN_L2;
+            case BTN_TR2:     return TELEMETRY_BTN_R2;
+            case BTN_SELECT:  return TELEMETRY_BTN_SHARE;
+            case BTN_START:   return TELEMETRY_BTN_OPTIONS;
+            case BTN_MODE:    return TELEMETRY_BTN_PS;
+            case BTN_THUMBL:  return TELEMETRY_BTN_L3;
+            case BTN_THUMBR:  return TELEMETRY_BTN_R3;
+            default:          return 0;
+        }
+    }
 };
 
 // Global controller instance for signal handling
@@ -354,11 +435,18 @@ void signalHandler(int signal) {
 }
 
 int main(int argc, char* argv[]) {
+    // Usage: sudo ./ps4_controller_integrated [--quiet] [/dev/input/eventX]
     std::string devicePath = "/dev/input/event3";
+    bool quietConsole = false;
     
     // Parse command line arguments
-    if (argc > 1) {
-        devicePath = argv[1];
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quiet") {
+            quietConsole = true;
+        } else {
+            devicePath = arg;
+        }
     }
     
     std::cout << "PS4 Controller Integrated Test" << std::endl;
@@ -366,6 +454,7 @@ int main(int argc, char* argv[]) {
     std::cout << "Device path: " << devicePath << std::endl;
     std::cout << "Debug mode: " << (DEBUG_MODE ? "ON" : "OFF") << std::endl;
     std::cout << "Debug level: " << DEBUG_LEVEL << std::endl;
+    std::cout << "Console events: " << (quietConsole ? "OFF when telemetry is open" : "ON") << std::endl;
     std::cout << "==============================" << std::endl;
     
     // Set up signal handling
@@ -376,7 +465,7 @@ int main(int argc, char* argv[]) {
         PS4Controller controller;
         g_controller = &controller;
         
-        if (!controller.initialize(devicePath)) {
+        if (!controller.initialize(devicePath, quietConsole)) {
             std::cerr << "Failed to initialize controller" << std::endl;
             return 1;
         }
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <iomanip>
+#include <atomic>
+#include <algorithm>
+#include <signal.h>
+#include "telemetry_shm.h"
+
+// telemetry_reader.cpp
+// Attaches to the controller's shared-memory telemetry ring and prints live
+// record rate, publish-to-read latency, loop timing and the latest sample.
+// Readers never block the writer and may attach or detach at any time.
+
+static constexpr int POLL_INTERVAL_MS = 1;
+static constexpr int REPORT_INTERVAL_MS = 1000;
+static constexpr int REATTACH_INTERVAL_MS = 500;
+
+static std::atomic<bool> g_running(true);
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+struct WindowStats {
+    uint64_t records = 0;
+    uint64_t latencySumNs = 0;
+    uint64_t latencyMaxNs = 0;
+    uint64_t loopPeriodSumUs = 0;
+    uint32_t loopWorkMaxUs = 0;
+
+    void add(const TelemetryRecord& record, uint64_t nowNs) {
+        uint64_t latency = nowNs > record.timestampNs ? nowNs - record.timestampNs : 0;
+        ++records;
+        latencySumNs += latency;
+        latencyMaxNs = std::max(latencyMaxNs, latency);
+        loopPeriodSumUs += record.loopPeriodUs;
+        loopWorkMaxUs = std::max(loopWorkMaxUs, record.loopWorkUs);
+    }
+};
+
+void printReport(const WindowStats& stats, const TelemetryRecord& last, double seconds, uint64_t overruns, uint64_t restarts) {
+    double rate = seconds > 0.0 ? stats.records / seconds : 0.0;
+    double avgLatencyUs = stats.records ? (stats.latencySumNs / 1000.0) / stats.records : 0.0;
+    double avgPeriodMs = stats.records ? (stats.loopPeriodSumUs / 1000.0) / stats.records : 0.0;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "[TELEMETRY] " << rate << " Hz"
+              << " | latency avg " << avgLatencyUs << " us, max " << stats.latencyMaxNs / 1000.0 << " us"
+              << " | loop " << avgPeriodMs << " ms, work max " << stats.loopWorkMaxUs << " us"
+              << " | overruns " << overruns << " | restarts " << restarts << std::endl;
+
+    if (stats.records) {
+        std::cout << std::setprecision(2)
+                  << "            Throttle: " << last.throttle << " | Steering: " << last.steering
+                  << " | Buttons: 0x" << std::hex << std::setw(4) << std::setfill('0') << last.buttons
+                  << std::dec << std::setfill(' ');
+        if (last.detectionValid) {
+            std::cout << " | Box: " << last.detectionX << "," << last.detectionY
+                      << " " << last.detectionW << "x" << last.detectionH;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string shmName = TELEMETRY_SHM_NAME;
+
+    // Parse command line arguments
+    if (argc > 1) {
+        shmName = argv[1];
+    }
+
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    std::cout << "Telemetry Reader" << std::endl;
+    std::cout << "================" << std::endl;
+    std::cout << "Shared memory: " << shmName << std::endl;
+    std::cout << "Press Ctrl+C to exit" << std::endl;
+    std::cout << "================" << std::endl;
+
+    TelemetryReader reader;
+    bool waitingReported = false;
+    bool attachedBefore = false;
+
+    // Cumulative across reattachments; the reader's own counters reset on attach
+    uint64_t totalOverruns = 0;
+    uint64_t totalRestarts = 0;
+
+    while (g_running) {
+        if (!reader.isAttached()) {
+            std::string error;
+            if (!reader.attach(error, shmName)) {
+                if (!waitingReported) {
+                    std::cerr << "Waiting for writer: " << error << std::endl;
+                    waitingReported = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(REATTACH_INTERVAL_MS));
+                continue;
+            }
+            waitingReported = false;
+            // A new object behind the name means the writer was restarted
+            if (attachedBefore) {
+                ++totalRestarts;
+            }
+            attachedBefore = true;
+            std::cout << "Attached to " << shmName << std::endl;
+        }
+
+        WindowStats stats;
+        TelemetryRecord record{};
+        TelemetryRecord last{};
+        auto windowStart = std::chrono::steady_clock::now();
+        auto windowEnd = windowStart + std::chrono::milliseconds(REPORT_INTERVAL_MS);
+
+        while (g_running && std::chrono::steady_clock::now() < windowEnd) {
+            while (reader.next(record)) {
+                stats.add(record, telemetryNowNs());
+                last = record;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - windowStart).count();
+        printReport(stats, last, seconds, totalOverruns + reader.overruns(), totalRestarts + reader.restarts());
+
+        // Restarts into the same object are handled by next(); reattach only
+        // once the writer has unlinked the name or replaced the object
+        if (!reader.isCurrent()) {
+            std::cout << "Telemetry region removed or replaced, detaching" << std::endl;
+            totalOverruns += reader.overruns();
+            totalRestarts += reader.restarts();
+            reader.detach();
+        }
+    }
+
+    std::cout << "Program terminated successfully" << std::endl;
+    return 0;
+}
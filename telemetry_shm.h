@@ -0,0 +1,426 @@
+#ifndef TELEMETRY_SHM_H
+#define TELEMETRY_SHM_H
+
+// telemetry_shm.h
+// POSIX shared-memory telemetry ring shared by the controller (writer) and any
+// number of local readers (dashboard, recorder, test harness).
+//
+// Layout: a fixed header followed by TELEMETRY_RING_CAPACITY slots. The single
+// writer never waits on readers: each slot is guarded by a sequence counter
+// (odd while being written, even once published), and readers that fall more
+// than one lap behind simply skip ahead and count the overrun. Each writer
+// session bumps the header epoch so attached readers resync after a restart.
+//
+// Ownership: a writer holds flock(LOCK_EX) on the shm fd for its whole
+// session. A region whose lock can be taken has no live writer and may be
+// reinitialized; the name is only unlinked while holding that lock.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+static constexpr const char* TELEMETRY_SHM_NAME = "/rc_car_telemetry";
+static constexpr uint32_t TELEMETRY_MAGIC = 0x52435431;  // "RCT1"
+static constexpr uint32_t TELEMETRY_VERSION = 2;
+static constexpr uint32_t TELEMETRY_RING_CAPACITY = 1024;  // Must be a power of two
+
+static_assert((TELEMETRY_RING_CAPACITY & (TELEMETRY_RING_CAPACITY - 1)) == 0,
+              "TELEMETRY_RING_CAPACITY must be a power of two");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory telemetry requires lock-free 64-bit atomics");
+
+// Button bits used in TelemetryRecord::buttons
+enum TelemetryButton : uint32_t {
+    TELEMETRY_BTN_TRIANGLE = 1u << 0,
+    TELEMETRY_BTN_CROSS    = 1u << 1,
+    TELEMETRY_BTN_SQUARE   = 1u << 2,
+    TELEMETRY_BTN_CIRCLE   = 1u << 3,
+    TELEMETRY_BTN_L1       = 1u << 4,
+    TELEMETRY_BTN_R1       = 1u << 5,
+    TELEMETRY_BTN_L2       = 1u << 6,
+    TELEMETRY_BTN_R2       = 1u << 7,
+    TELEMETRY_BTN_SHARE    = 1u << 8,
+    TELEMETRY_BTN_OPTIONS  = 1u << 9,
+    TELEMETRY_BTN_PS       = 1u << 10,
+    TELEMETRY_BTN_L3       = 1u << 11,
+    TELEMETRY_BTN_R3       = 1u << 12
+};
+
+// Fixed-layout record; only plain integer/float fields so the layout is
+// identical for every process built from this header.
+struct TelemetryRecord {
+    uint64_t timestampNs;     // steady_clock (CLOCK_MONOTONIC) at publish time
+    int16_t rawAxes[4];       // SDL axes 0..3, unscaled
+    float throttle;           // After deadzone, [-1.0, 1.0]
+    float steering;           // After deadzone, [-1.0, 1.0]
+    uint32_t buttons;         // TelemetryButton bitmask of held buttons
+    uint32_t loopPeriodUs;    // Time since the previous loop iteration
+    uint32_t loopWorkUs;      // Time spent in the loop body before publishing
+    uint32_t detectionValid;  // Non-zero when the detection box below is set
+    int32_t detectionX;
+    int32_t detectionY;
+    int32_t detectionW;
+    int32_t detectionH;
+    float detectionCoverage;  // Fraction of frame covered by the mask
+    uint32_t reserved;
+};
+
+struct TelemetrySlot {
+    std::atomic<uint64_t> seq;
+    TelemetryRecord record;
+};
+
+struct TelemetryHeader {
+    std::atomic<uint32_t> magic;       // TELEMETRY_MAGIC once the header is initialized
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t recordSize;
+    std::atomic<uint64_t> epoch;       // Bumped by every writer session
+    std::atomic<uint64_t> writeIndex;  // Number of records published so far
+    std::atomic<uint32_t> writerPid;   // Diagnostic only; ownership is the flock
+    uint32_t reserved;
+};
+
+struct TelemetryRegion {
+    TelemetryHeader header;
+    TelemetrySlot slots[TELEMETRY_RING_CAPACITY];
+};
+
+inline uint64_t telemetryNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Identity (device, inode) of the object the shm name currently points to.
+// Returns false if the name does not exist.
+inline bool telemetryNameIdentity(const std::string& name, dev_t& dev, ino_t& ino) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    ::close(fd);
+    if (ok) {
+        dev = st.st_dev;
+        ino = st.st_ino;
+    }
+    return ok;
+}
+
+// True if fd refers to the object the shm name currently points to
+inline bool telemetryFdMatchesName(int fd, const std::string& name) {
+    struct stat st;
+    dev_t dev;
+    ino_t ino;
+    return fstat(fd, &st) == 0 && telemetryNameIdentity(name, dev, ino) &&
+           st.st_dev == dev && st.st_ino == ino;
+}
+
+class TelemetryWriter {
+private:
+    std::string name_;
+    int fd_;  // Held open (and flocked) for the whole writer session
+    TelemetryRegion* region_;
+    uint64_t nextIndex_;
+
+    static constexpr int OPEN_ATTEMPTS = 3;
+
+public:
+    TelemetryWriter() : name_(TELEMETRY_SHM_NAME), fd_(-1), region_(nullptr), nextIndex_(0) {}
+
+    ~TelemetryWriter() {
+        close();
+    }
+
+    // Prevent copying
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    // Creates the shared-memory object, or takes over one left behind by a
+    // writer that is no longer running. Refuses to open while another writer
+    // holds the region lock. On failure returns false and fills errorMessage;
+    // the caller can keep running without telemetry.
+    bool open(std::string& errorMessage, const std::string& name = TELEMETRY_SHM_NAME) {
+        close();
+
+        for (int attempt = 0; attempt < OPEN_ATTEMPTS; ++attempt) {
+            int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+            if (fd < 0) {
+                errorMessage = "shm_open('" + name + "') failed: " + std::strerror(errno);
+                return false;
+            }
+
+            if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+                if (errno == EWOULDBLOCK) {
+                    errorMessage = "Telemetry region '" + name + "' is owned by another running writer";
+                } else {
+                    errorMessage = "flock('" + name + "') failed: " + std::strerror(errno);
+                }
+                ::close(fd);
+                return false;
+            }
+
+            // The previous owner may have unlinked this object just before
+            // releasing its lock; retry against whatever the name holds now
+            if (!telemetryFdMatchesName(fd, name)) {
+                ::close(fd);
+                continue;
+            }
+
+            return initializeRegion(fd, name, errorMessage);
+        }
+
+        errorMessage = "Telemetry region '" + name + "' kept changing while opening";
+        return false;
+    }
+
+    void close() {
+        if (region_) {
+            region_->header.writerPid.store(0, std::memory_order_release);
+            munmap(region_, sizeof(TelemetryRegion));
+            region_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            // Unlink while still holding the lock, and only our own object.
+            // Attached readers keep their mapping; new readers will not find it
+            if (telemetryFdMatchesName(fd_, name_)) {
+                shm_unlink(name_.c_str());
+            }
+            ::close(fd_);  // Releases the lock
+            fd_ = -1;
+        }
+    }
+
+    bool isOpen() const {
+        return region_ != nullptr;
+    }
+
+    // Single-producer publish; never blocks.
+    void publish(const TelemetryRecord& record) {
+        if (!region_) {
+            return;
+        }
+
+        uint64_t index = nextIndex_++;
+        TelemetrySlot& slot = region_->slots[index & (TELEMETRY_RING_CAPACITY - 1)];
+
+        slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&slot.record, &record, sizeof(TelemetryRecord));
+        slot.seq.store(2 * index + 2, std::memory_order_release);
+
+        region_->header.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+private:
+    // Called with fd locked. Any previous contents belong to a writer that is
+    // gone; keep its epoch so attached readers see a new session.
+    bool initializeRegion(int fd, const std::string& name, std::string& errorMessage) {
+        if (ftruncate(fd, sizeof(TelemetryRegion)) < 0) {
+            errorMessage = "ftruncate failed: " + std::string(std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        void* addr = mmap(nullptr, sizeof(TelemetryRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            errorMessage = "mmap failed: " + std::string(std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        fd_ = fd;
+        name_ = name;
+        region_ = static_cast<TelemetryRegion*>(addr);
+
+        TelemetryHeader& header = region_->header;
+        uint64_t epoch = 0;
+        if (header.magic.load(std::memory_order_acquire) == TELEMETRY_MAGIC &&
+            header.version == TELEMETRY_VERSION) {
+            epoch = header.epoch.load(std::memory_order_relaxed);
+        }
+
+        // Invalidate the header while resetting so late readers do not attach
+        // to a half-initialized ring.
+        header.magic.store(0, std::memory_order_seq_cst);
+        header.version = TELEMETRY_VERSION;
+        header.capacity = TELEMETRY_RING_CAPACITY;
+        header.recordSize = sizeof(TelemetryRecord);
+        header.writeIndex.store(0, std::memory_order_relaxed);
+        header.writerPid.store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+        for (auto& slot : region_->slots) {
+            slot.seq.store(0, std::memory_order_relaxed);
+        }
+        header.epoch.store(epoch + 1, std::memory_order_release);
+        header.magic.store(TELEMETRY_MAGIC, std::memory_order_release);
+
+        nextIndex_ = 0;
+        return true;
+    }
+};
+
+class TelemetryReader {
+private:
+    const TelemetryRegion* region_;
+    std::string name_;
+    dev_t dev_;
+    ino_t ino_;
+    uint64_t cursor_;
+    uint64_t epoch_;
+    uint64_t overruns_;
+    uint64_t restarts_;
+
+public:
+    TelemetryReader() : region_(nullptr), dev_(0), ino_(0), cursor_(0), epoch_(0), overruns_(0), restarts_(0) {}
+
+    ~TelemetryReader() {
+        detach();
+    }
+
+    // Prevent copying
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool attach(std::string& errorMessage, const std::string& name = TELEMETRY_SHM_NAME) {
+        detach();
+
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            errorMessage = "shm_open('" + name + "') failed: " + std::strerror(errno);
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(TelemetryRegion)) {
+            errorMessage = "Telemetry region is missing or too small";
+            ::close(fd);
+            return false;
+        }
+
+        void* addr = mmap(nullptr, sizeof(TelemetryRegion), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            errorMessage = "mmap failed: " + std::string(std::strerror(errno));
+            return false;
+        }
+
+        const auto* region = static_cast<const TelemetryRegion*>(addr);
+        if (region->header.magic.load(std::memory_order_acquire) != TELEMETRY_MAGIC ||
+            region->header.version != TELEMETRY_VERSION ||
+            region->header.capacity != TELEMETRY_RING_CAPACITY ||
+            region->header.recordSize != sizeof(TelemetryRecord)) {
+            errorMessage = "Telemetry region has an incompatible layout";
+            munmap(const_cast<TelemetryRegion*>(region), sizeof(TelemetryRegion));
+            return false;
+        }
+
+        region_ = region;
+        name_ = name;
+        dev_ = st.st_dev;
+        ino_ = st.st_ino;
+        // Start from the newest record rather than replaying the whole ring
+        epoch_ = region_->header.epoch.load(std::memory_order_acquire);
+        cursor_ = region_->header.writeIndex.load(std::memory_order_acquire);
+        overruns_ = 0;
+        restarts_ = 0;
+        return true;
+    }
+
+    void detach() {
+        if (region_) {
+            munmap(const_cast<TelemetryRegion*>(region_), sizeof(TelemetryRegion));
+            region_ = nullptr;
+        }
+    }
+
+    bool isAttached() const {
+        return region_ != nullptr;
+    }
+
+    // True while the shm name still points at the mapped object. A crashed
+    // writer leaves the name linked, and its successor reuses the object, so
+    // next() resyncs by epoch; only a removed or replaced name needs reattach.
+    bool isCurrent() const {
+        dev_t dev;
+        ino_t ino;
+        return region_ && telemetryNameIdentity(name_, dev, ino) && dev == dev_ && ino == ino_;
+    }
+
+    // Counters cover the current attachment only
+    uint64_t overruns() const {
+        return overruns_;
+    }
+
+    // Writer sessions that replaced the one seen at attach time
+    uint64_t restarts() const {
+        return restarts_;
+    }
+
+    // Copies the next unread record into out. Returns false when caught up.
+    bool next(TelemetryRecord& out) {
+        if (!region_) {
+            return false;
+        }
+
+        const TelemetryHeader& header = region_->header;
+        while (true) {
+            // A writer is (re)initializing the ring
+            if (header.magic.load(std::memory_order_acquire) != TELEMETRY_MAGIC) {
+                return false;
+            }
+
+            uint64_t epoch = header.epoch.load(std::memory_order_acquire);
+            uint64_t head = header.writeIndex.load(std::memory_order_acquire);
+
+            // New writer session: its indices restart at 0, so resync to the
+            // oldest record it still holds instead of waiting past the old cursor
+            if (epoch != epoch_ || head < cursor_) {
+                if (epoch != epoch_) {
+                    ++restarts_;
+                }
+                epoch_ = epoch;
+                cursor_ = head > TELEMETRY_RING_CAPACITY ? head - TELEMETRY_RING_CAPACITY : 0;
+            }
+
+            if (cursor_ >= head) {
+                return false;
+            }
+
+            // Fell more than a lap behind: jump to the oldest slot still intact
+            if (head - cursor_ > TELEMETRY_RING_CAPACITY) {
+                uint64_t oldest = head - TELEMETRY_RING_CAPACITY;
+                overruns_ += oldest - cursor_;
+                cursor_ = oldest;
+            }
+
+            const TelemetrySlot& slot = region_->slots[cursor_ & (TELEMETRY_RING_CAPACITY - 1)];
+            uint64_t expected = 2 * cursor_ + 2;
+
+            uint64_t before = slot.seq.load(std::memory_order_acquire);
+            std::memcpy(&out, &slot.record, sizeof(TelemetryRecord));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot.seq.load(std::memory_order_relaxed);
+
+            if (before == expected && after == expected) {
+                ++cursor_;
+                return true;
+            }
+
+            // Slot was overwritten while copying; count it and move on
+            ++overruns_;
+            ++cursor_;
+        }
+    }
+};
+
+#endif // TELEMETRY_SHM_H